@@ -0,0 +1,698 @@
+#include "batch_gcd.h"
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+// Little-endian base 2^64 big integer, normalized (no leading zero limbs, zero is empty).
+using Limbs = std::vector<unsigned long long>;
+using u128 = unsigned __int128;
+
+const size_t karatsuba_threshold = 32;
+const size_t newton_threshold = 64;
+const size_t ntt_threshold = 8192;
+
+// Runs f(i) for i in [0, count) on up to `threads` worker threads, in contiguous blocks.
+template <typename F>
+void parallel_for(size_t count, unsigned int threads, F f) {
+    unsigned int workers = static_cast<unsigned int>(std::min<size_t>(threads, count));
+    if (workers <= 1) {
+        for (size_t i = 0; i < count; ++i) f(i);
+        return;
+    }
+    std::vector<std::thread> pool;
+    size_t block = (count + workers - 1) / workers;
+    for (unsigned int w = 0; w < workers; ++w) {
+        size_t begin = w * block;
+        size_t end = std::min(count, begin + block);
+        if (begin >= end) break;
+        pool.emplace_back([begin, end, &f] {
+            for (size_t i = begin; i < end; ++i) f(i);
+        });
+    }
+    for (auto& worker : pool) worker.join();
+}
+
+void normalize(Limbs& a) {
+    while (!a.empty() && a.back() == 0) a.pop_back();
+}
+
+int compare(const Limbs& a, const Limbs& b) {
+    if (a.size() != b.size()) return a.size() < b.size() ? -1 : 1;
+    for (size_t i = a.size(); i-- > 0;) {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+Limbs add(const Limbs& a, const Limbs& b) {
+    const Limbs& x = a.size() >= b.size() ? a : b;
+    const Limbs& y = a.size() >= b.size() ? b : a;
+    Limbs result(x.size() + 1);
+    unsigned long long carry = 0;
+    for (size_t i = 0; i < x.size(); ++i) {
+        u128 t = static_cast<u128>(x[i]) + (i < y.size() ? y[i] : 0) + carry;
+        result[i] = static_cast<unsigned long long>(t);
+        carry = static_cast<unsigned long long>(t >> 64);
+    }
+    result[x.size()] = carry;
+    normalize(result);
+    return result;
+}
+
+// a - b, requires a >= b
+Limbs sub(const Limbs& a, const Limbs& b) {
+    Limbs result(a.size());
+    unsigned long long borrow = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        unsigned long long bi = i < b.size() ? b[i] : 0;
+        u128 t = static_cast<u128>(a[i]) - bi - borrow;
+        result[i] = static_cast<unsigned long long>(t);
+        borrow = (t >> 64) != 0 ? 1 : 0;
+    }
+    normalize(result);
+    return result;
+}
+
+Limbs shift_left_limbs(const Limbs& a, size_t count) {
+    if (a.empty()) return {};
+    Limbs result(count, 0);
+    result.insert(result.end(), a.begin(), a.end());
+    return result;
+}
+
+Limbs shift_right_limbs(const Limbs& a, size_t count) {
+    if (a.size() <= count) return {};
+    return Limbs(a.begin() + count, a.end());
+}
+
+Limbs power_of_base(size_t exponent) {
+    Limbs result(exponent + 1, 0);
+    result[exponent] = 1;
+    return result;
+}
+
+// r[0, an + bn) = a * b
+void mul_basecase(unsigned long long* r, const unsigned long long* a, size_t an, const unsigned long long* b, size_t bn) {
+    std::fill(r, r + an + bn, 0);
+    for (size_t i = 0; i < an; ++i) {
+        unsigned long long carry = 0;
+        for (size_t j = 0; j < bn; ++j) {
+            u128 t = static_cast<u128>(a[i]) * b[j] + r[i + j] + carry;
+            r[i + j] = static_cast<unsigned long long>(t);
+            carry = static_cast<unsigned long long>(t >> 64);
+        }
+        r[i + bn] = carry;
+    }
+}
+
+// r[0, an) = a + b for an >= bn, returns the carry out
+unsigned long long add_limbs(unsigned long long* r, const unsigned long long* a, size_t an, const unsigned long long* b, size_t bn) {
+    unsigned long long carry = 0;
+    for (size_t i = 0; i < an; ++i) {
+        u128 t = static_cast<u128>(a[i]) + (i < bn ? b[i] : 0) + carry;
+        r[i] = static_cast<unsigned long long>(t);
+        carry = static_cast<unsigned long long>(t >> 64);
+    }
+    return carry;
+}
+
+// r[0, rn) += b[0, bn), carry propagates through r
+void add_in_place(unsigned long long* r, size_t rn, const unsigned long long* b, size_t bn) {
+    unsigned long long carry = 0;
+    for (size_t i = 0; i < rn && (i < bn || carry != 0); ++i) {
+        u128 t = static_cast<u128>(r[i]) + (i < bn ? b[i] : 0) + carry;
+        r[i] = static_cast<unsigned long long>(t);
+        carry = static_cast<unsigned long long>(t >> 64);
+    }
+}
+
+// r[0, rn) -= b[0, bn), requires r >= b
+void sub_in_place(unsigned long long* r, size_t rn, const unsigned long long* b, size_t bn) {
+    unsigned long long borrow = 0;
+    for (size_t i = 0; i < rn && (i < bn || borrow != 0); ++i) {
+        u128 t = static_cast<u128>(r[i]) - (i < bn ? b[i] : 0) - borrow;
+        r[i] = static_cast<unsigned long long>(t);
+        borrow = (t >> 64) != 0 ? 1 : 0;
+    }
+}
+
+size_t karatsuba_scratch(size_t n) {
+    if (n < karatsuba_threshold) return 0;
+    size_t h = n - n / 2;
+    return 4 * (h + 1) + karatsuba_scratch(h + 1);
+}
+
+// r[0, 2n) = a[0, n) * b[0, n), using karatsuba_scratch(n) limbs of scratch.
+void karatsuba(unsigned long long* r, const unsigned long long* a, const unsigned long long* b, size_t n, unsigned long long* scratch) {
+    if (n < karatsuba_threshold) {
+        mul_basecase(r, a, n, b, n);
+        return;
+    }
+    size_t l = n / 2, h = n - l;
+    unsigned long long* sa = scratch;
+    unsigned long long* sb = sa + h + 1;
+    unsigned long long* z1 = sb + h + 1;
+    unsigned long long* next = z1 + 2 * (h + 1);
+
+    karatsuba(r, a, b, l, next);
+    karatsuba(r + 2 * l, a + l, b + l, h, next);
+    sa[h] = add_limbs(sa, a + l, h, a, l);
+    sb[h] = add_limbs(sb, b + l, h, b, l);
+    karatsuba(z1, sa, sb, h + 1, next);
+
+    // z1 = (a0 + a1)(b0 + b1) - a0 b0 - a1 b1
+    sub_in_place(z1, 2 * (h + 1), r, 2 * l);
+    sub_in_place(z1, 2 * (h + 1), r + 2 * l, 2 * h);
+    size_t z1_size = 2 * (h + 1);
+    while (z1_size > 0 && z1[z1_size - 1] == 0) --z1_size;
+    add_in_place(r + l, 2 * n - l, z1, z1_size);
+}
+
+// Number-theoretic transform over the prime 2^64 - 2^32 + 1, which has roots of unity of order 2^32.
+const unsigned long long ntt_prime = 0xFFFFFFFF00000001ULL;
+const unsigned long long ntt_generator = 7;
+
+// Branch-free: the operands are effectively random, so any data-dependent branch would mispredict.
+unsigned long long ntt_add(unsigned long long a, unsigned long long b) {
+    u128 s = static_cast<u128>(a) + b;
+    unsigned long long wide = (s >= ntt_prime) ? ~0ULL : 0;
+    return static_cast<unsigned long long>(s - (ntt_prime & wide));
+}
+
+unsigned long long ntt_sub(unsigned long long a, unsigned long long b) {
+    unsigned long long d = a - b;
+    return d + (ntt_prime & (0 - static_cast<unsigned long long>(a < b)));
+}
+
+// 2^64 = 2^32 - 1 and 2^96 = -1 modulo the prime, so a 128-bit product folds without division.
+unsigned long long ntt_mul(unsigned long long a, unsigned long long b) {
+    const unsigned long long epsilon = 0xFFFFFFFFULL;
+    u128 x = static_cast<u128>(a) * b;
+    unsigned long long lo = static_cast<unsigned long long>(x);
+    unsigned long long hi = static_cast<unsigned long long>(x >> 64);
+    unsigned long long t = lo - (hi >> 32);
+    t -= epsilon & (0 - static_cast<unsigned long long>(lo < (hi >> 32)));
+    unsigned long long result = t + (hi & epsilon) * epsilon;
+    result += epsilon & (0 - static_cast<unsigned long long>(result < t));
+    return result - (ntt_prime & (0 - static_cast<unsigned long long>(result >= ntt_prime)));
+}
+
+unsigned long long ntt_pow(unsigned long long base, unsigned long long exponent) {
+    unsigned long long result = 1;
+    while (exponent > 0) {
+        if (exponent & 1) result = ntt_mul(result, base);
+        base = ntt_mul(base, base);
+        exponent >>= 1;
+    }
+    return result;
+}
+
+// The forward transform is decimation-in-frequency and leaves its output in bit-reversed order; the
+// inverse is decimation-in-time and reads that order back, so a convolution never permutes the data.
+void ntt(std::vector<unsigned long long>& a, bool invert, unsigned int threads) {
+    size_t n = a.size();
+    std::vector<unsigned long long> twiddles(n / 2);
+    for (size_t stage = 0; (size_t(2) << stage) <= n; ++stage) {
+        size_t len = invert ? size_t(2) << stage : n >> stage;
+        size_t half = len / 2;
+        unsigned long long root = ntt_pow(ntt_generator, (ntt_prime - 1) / len);
+        if (invert) root = ntt_pow(root, ntt_prime - 2);
+        twiddles[0] = 1;
+        for (size_t j = 1; j < half; ++j) twiddles[j] = ntt_mul(twiddles[j - 1], root);
+
+        // Butterflies of one stage are independent; large transforms split them across the workers.
+        size_t butterflies = n / 2;
+        unsigned int workers = n >= (1 << 16) ? threads : 1;
+        parallel_for(workers, workers, [&](size_t w) {
+            for (size_t k = butterflies * w / workers; k < butterflies * (w + 1) / workers; ++k) {
+                size_t j = k & (half - 1);
+                unsigned long long* lo = a.data() + 2 * k - j;
+                unsigned long long* hi = lo + half;
+                unsigned long long u = *lo;
+                unsigned long long v = *hi;
+                if (invert) {
+                    v = ntt_mul(v, twiddles[j]);
+                    *lo = ntt_add(u, v);
+                    *hi = ntt_sub(u, v);
+                } else {
+                    *lo = ntt_add(u, v);
+                    *hi = ntt_mul(ntt_sub(u, v), twiddles[j]);
+                }
+            }
+        });
+    }
+
+    if (invert) {
+        unsigned long long n_inv = ntt_pow(n % ntt_prime, ntt_prime - 2);
+        for (auto& x : a) x = ntt_mul(x, n_inv);
+    }
+}
+
+// Limbs are cut into 16-bit digits so every convolution sum (< digits * 2^32) stays below the prime.
+std::vector<unsigned long long> to_digits(const Limbs& a, size_t size) {
+    std::vector<unsigned long long> digits(size, 0);
+    for (size_t i = 0; i < a.size(); ++i) {
+        for (size_t d = 0; d < 4; ++d) digits[4 * i + d] = (a[i] >> (16 * d)) & 0xFFFF;
+    }
+    return digits;
+}
+
+Limbs mul_ntt(const Limbs& a, const Limbs& b, unsigned int threads) {
+    size_t size = 1;
+    while (size < 4 * (a.size() + b.size())) size <<= 1;
+
+    std::vector<unsigned long long> fa = to_digits(a, size);
+    ntt(fa, false, threads);
+    if (&a == &b) {
+        for (auto& x : fa) x = ntt_mul(x, x);
+    } else {
+        std::vector<unsigned long long> fb = to_digits(b, size);
+        ntt(fb, false, threads);
+        for (size_t i = 0; i < size; ++i) fa[i] = ntt_mul(fa[i], fb[i]);
+    }
+    ntt(fa, true, threads);
+
+    Limbs result(a.size() + b.size(), 0);
+    u128 carry = 0;
+    for (size_t i = 0; i < 4 * result.size(); ++i) {
+        carry += i < size ? fa[i] : 0;
+        result[i / 4] |= static_cast<unsigned long long>(carry & 0xFFFF) << (16 * (i % 4));
+        carry >>= 16;
+    }
+    normalize(result);
+    return result;
+}
+
+Limbs mul(const Limbs& a, const Limbs& b, unsigned int spare_threads = 1);
+
+// Splits the longer operand into b-sized pieces, each multiplied by Karatsuba.
+Limbs mul_unbalanced(const Limbs& a, const Limbs& b) {
+    size_t n = b.size();
+    Limbs result(a.size() + n, 0);
+    Limbs product(2 * n), scratch(karatsuba_scratch(n));
+    for (size_t offset = 0; offset < a.size(); offset += n) {
+        size_t len = std::min(n, a.size() - offset);
+        if (len == n) {
+            karatsuba(product.data(), a.data() + offset, b.data(), n, scratch.data());
+            add_in_place(result.data() + offset, result.size() - offset, product.data(), 2 * n);
+        } else {
+            Limbs tail(a.begin() + offset, a.end());
+            normalize(tail);
+            Limbs partial = mul(b, tail);
+            add_in_place(result.data() + offset, result.size() - offset, partial.data(), partial.size());
+        }
+    }
+    normalize(result);
+    return result;
+}
+
+// Schoolbook for short operands, Karatsuba up to ntt_threshold limbs, NTT above;
+// spare_threads > 1 spreads the NTT butterflies across threads.
+Limbs mul(const Limbs& a, const Limbs& b, unsigned int spare_threads) {
+    if (a.size() < b.size()) return mul(b, a, spare_threads);
+    if (b.empty()) return {};
+    if (b.size() < karatsuba_threshold) {
+        Limbs result(a.size() + b.size());
+        mul_basecase(result.data(), a.data(), a.size(), b.data(), b.size());
+        normalize(result);
+        return result;
+    }
+    if (b.size() < ntt_threshold) return mul_unbalanced(a, b);
+    return mul_ntt(a, b, spare_threads);
+}
+
+// Knuth's Algorithm D: returns floor(u / v) and stores u mod v in *remainder when given.
+Limbs divmod(const Limbs& u, const Limbs& v, Limbs* remainder) {
+    if (v.empty()) throw std::runtime_error("Division by zero");
+    if (compare(u, v) < 0) {
+        if (remainder) *remainder = u;
+        return {};
+    }
+
+    if (v.size() == 1) {
+        Limbs quotient(u.size());
+        unsigned long long rem = 0;
+        for (size_t i = u.size(); i-- > 0;) {
+            u128 cur = (static_cast<u128>(rem) << 64) | u[i];
+            quotient[i] = static_cast<unsigned long long>(cur / v[0]);
+            rem = static_cast<unsigned long long>(cur % v[0]);
+        }
+        normalize(quotient);
+        if (remainder) *remainder = rem ? Limbs{rem} : Limbs{};
+        return quotient;
+    }
+
+    size_t n = v.size();
+    size_t m = u.size() - n;
+    int s = __builtin_clzll(v.back());
+
+    Limbs vn(n), un(u.size() + 1);
+    for (size_t i = n - 1; i > 0; --i) {
+        vn[i] = (v[i] << s) | (s ? v[i - 1] >> (64 - s) : 0);
+    }
+    vn[0] = v[0] << s;
+    un[u.size()] = s ? u.back() >> (64 - s) : 0;
+    for (size_t i = u.size() - 1; i > 0; --i) {
+        un[i] = (u[i] << s) | (s ? u[i - 1] >> (64 - s) : 0);
+    }
+    un[0] = u[0] << s;
+
+    Limbs quotient(m + 1);
+    for (size_t j = m + 1; j-- > 0;) {
+        u128 numerator = (static_cast<u128>(un[j + n]) << 64) | un[j + n - 1];
+        u128 qhat = numerator / vn[n - 1];
+        u128 rhat = numerator % vn[n - 1];
+        while ((qhat >> 64) != 0 || qhat * vn[n - 2] > ((rhat << 64) | un[j + n - 2])) {
+            --qhat;
+            rhat += vn[n - 1];
+            if ((rhat >> 64) != 0) break;
+        }
+
+        __int128 borrow = 0;
+        for (size_t i = 0; i < n; ++i) {
+            u128 product = qhat * vn[i];
+            __int128 t = static_cast<__int128>(un[i + j]) - borrow - static_cast<unsigned long long>(product);
+            un[i + j] = static_cast<unsigned long long>(t);
+            borrow = static_cast<__int128>(product >> 64) - (t >> 64);
+        }
+        __int128 t = static_cast<__int128>(un[j + n]) - borrow;
+        un[j + n] = static_cast<unsigned long long>(t);
+
+        if (t < 0) {
+            // qhat was one too large: add v back
+            --qhat;
+            unsigned long long carry = 0;
+            for (size_t i = 0; i < n; ++i) {
+                u128 sum = static_cast<u128>(un[i + j]) + vn[i] + carry;
+                un[i + j] = static_cast<unsigned long long>(sum);
+                carry = static_cast<unsigned long long>(sum >> 64);
+            }
+            un[j + n] += carry;
+        }
+        quotient[j] = static_cast<unsigned long long>(qhat);
+    }
+    normalize(quotient);
+
+    if (remainder) {
+        Limbs rem(n);
+        for (size_t i = 0; i < n; ++i) {
+            rem[i] = (un[i] >> s) | (s ? un[i + 1] << (64 - s) : 0);
+        }
+        normalize(rem);
+        *remainder = rem;
+    }
+    return quotient;
+}
+
+// Lower bound on floor(B^s / m), off by at most a few units, for s >= m.size().
+// Newton iteration from below never overshoots, so Barrett reduction needs no exact correction.
+Limbs reciprocal(const Limbs& m, size_t s) {
+    size_t k = m.size();
+    size_t precision = s - k + 1;
+    if (k > precision + 2) {
+        // Only the leading limbs of m matter; rounding the truncated m up keeps this a lower bound.
+        size_t drop = k - (precision + 2);
+        return reciprocal(add(shift_right_limbs(m, drop), Limbs{1}), s - drop);
+    }
+    if (precision <= newton_threshold) return divmod(power_of_base(s), m, nullptr);
+
+    // Half-precision estimate, scaled up to B^s / m.
+    size_t h = precision / 2 + 2;
+    Limbs x = shift_left_limbs(reciprocal(m, k + h - 1), precision - h);
+
+    // One Newton step: x += x * (B^s - m x) / B^s, dropping error limbs below the result precision.
+    Limbs base_s = power_of_base(s);
+    Limbs mx = mul(m, x);
+    if (compare(mx, base_s) > 0) return divmod(base_s, m, nullptr);
+    size_t drop = s > precision + 1 ? s - precision - 1 : 0;
+    Limbs error = shift_right_limbs(sub(base_s, mx), drop);
+    return add(x, shift_right_limbs(mul(x, error), s - drop));
+}
+
+// x mod m using a Barrett reciprocal, so the cost is a few multiplications instead of long division.
+Limbs reduce(const Limbs& x, const Limbs& m, unsigned int spare_threads) {
+    if (compare(x, m) < 0) return x;
+    size_t k = m.size();
+    size_t s = std::max(x.size(), k);
+    Limbs mu = reciprocal(m, s);
+    Limbs q = shift_right_limbs(mul(shift_right_limbs(x, k - 1), mu, spare_threads), s - k + 1);
+    Limbs r = sub(x, mul(q, m, spare_threads));
+    for (int steps = 0; compare(r, m) >= 0; ++steps) {
+        if (steps == 16) {
+            divmod(x, m, &r);
+            break;
+        }
+        r = sub(r, m);
+    }
+    return r;
+}
+
+u128 to_u128(const Limbs& a) {
+    u128 value = 0;
+    if (a.size() > 1) value = static_cast<u128>(a[1]) << 64;
+    if (!a.empty()) value |= a[0];
+    return value;
+}
+
+// Montgomery arithmetic modulo an odd 64-bit n, so Pollard rho needs no 128-bit division per step.
+struct Montgomery {
+    unsigned long long n;
+    unsigned long long n_inv;  // n^-1 mod 2^64
+
+    explicit Montgomery(unsigned long long modulus) : n(modulus), n_inv(modulus) {
+        for (int i = 0; i < 5; ++i) n_inv *= 2 - n * n_inv;
+    }
+
+    // a * b / 2^64 mod n
+    unsigned long long mul(unsigned long long a, unsigned long long b) const {
+        u128 t = static_cast<u128>(a) * b;
+        unsigned long long m = static_cast<unsigned long long>(t) * n_inv;
+        unsigned long long hi = static_cast<unsigned long long>(t >> 64);
+        unsigned long long mn_hi = static_cast<unsigned long long>((static_cast<u128>(m) * n) >> 64);
+        return hi >= mn_hi ? hi - mn_hi : hi + (n - mn_hi);
+    }
+};
+
+unsigned long long mul_mod(unsigned long long a, unsigned long long b, unsigned long long n) {
+    return static_cast<unsigned long long>(static_cast<u128>(a) * b % n);
+}
+
+unsigned long long pow_mod(unsigned long long base, unsigned long long exponent, unsigned long long n) {
+    unsigned long long result = 1 % n;
+    base %= n;
+    while (exponent > 0) {
+        if (exponent & 1) result = mul_mod(result, base, n);
+        base = mul_mod(base, base, n);
+        exponent >>= 1;
+    }
+    return result;
+}
+
+// Deterministic Miller-Rabin for 64-bit n (the first twelve prime bases suffice below 3.3e24).
+bool is_prime_u64(unsigned long long n) {
+    if (n < 2) return false;
+    for (unsigned long long p : {2ULL, 3ULL, 5ULL, 7ULL, 11ULL, 13ULL, 17ULL, 19ULL, 23ULL, 29ULL, 31ULL, 37ULL}) {
+        if (n % p == 0) return n == p;
+    }
+    unsigned long long d = n - 1;
+    int s = 0;
+    while ((d & 1) == 0) {
+        d >>= 1;
+        ++s;
+    }
+    for (unsigned long long a : {2ULL, 3ULL, 5ULL, 7ULL, 11ULL, 13ULL, 17ULL, 19ULL, 23ULL, 29ULL, 31ULL, 37ULL}) {
+        unsigned long long x = pow_mod(a, d, n);
+        if (x == 1 || x == n - 1) continue;
+        bool composite = true;
+        for (int r = 1; r < s && composite; ++r) {
+            x = mul_mod(x, x, n);
+            if (x == n - 1) composite = false;
+        }
+        if (composite) return false;
+    }
+    return true;
+}
+
+// Brent's variant of Pollard rho: a nontrivial factor of n in about n^(1/4) steps, or 0 when n is
+// prime (or 1) or every attempt cycles without splitting it.
+unsigned long long pollard_rho(unsigned long long n) {
+    if (n == 1 || is_prime_u64(n)) return 0;
+    for (unsigned long long p : {2ULL, 3ULL, 5ULL, 7ULL, 11ULL, 13ULL, 17ULL, 19ULL, 23ULL, 29ULL, 31ULL, 37ULL}) {
+        if (n % p == 0) return p;
+    }
+
+    Montgomery mont(n);
+    const size_t batch = 128;
+    const size_t max_steps = size_t(1) << 20;
+    for (unsigned long long c = 1; c < 32; ++c) {
+        auto step = [&](unsigned long long v) {
+            unsigned long long w = mont.mul(v, v) + c;
+            return w >= n || w < c ? w - n : w;
+        };
+        unsigned long long x = 2, y = 2, ys = 2, product = 1, g = 1;
+        for (size_t r = 1; g == 1 && r <= max_steps; r *= 2) {
+            x = y;
+            for (size_t i = 0; i < r; ++i) y = step(y);
+            for (size_t k = 0; k < r && g == 1; k += batch) {
+                ys = y;
+                for (size_t i = 0; i < std::min(batch, r - k); ++i) {
+                    y = step(y);
+                    product = mont.mul(product, x > y ? x - y : y - x);
+                }
+                g = std::gcd(product, n);
+            }
+        }
+        // The batched product collapsed to 0 mod n: replay the last batch one step at a time.
+        if (g == n) {
+            do {
+                ys = step(ys);
+                g = std::gcd(x > ys ? x - ys : ys - x, n);
+            } while (g == 1);
+        }
+        if (g != 1 && g != n) return g;
+    }
+    return 0;
+}
+
+bool parse_modulus_line(const std::string& line, unsigned long long& modulus) {
+    std::istringstream iss(line);
+    std::string first, second, extra;
+    if (!(iss >> first) || first[0] == '#') return false;
+    iss >> second >> extra;
+    if (!extra.empty()) throw std::runtime_error("Invalid modulus line: " + line);
+
+    size_t pos = 0;
+    const std::string& token = second.empty() ? first : second;
+    try {
+        modulus = std::stoull(token, &pos, 10);
+    } catch (const std::exception&) {
+        throw std::runtime_error("Invalid modulus line: " + line);
+    }
+    if (pos != token.size() || modulus < 2) throw std::runtime_error("Invalid modulus line: " + line);
+    return true;
+}
+
+} // namespace
+
+std::vector<unsigned long long> read_moduli(std::istream& in) {
+    std::vector<unsigned long long> moduli;
+    std::string line;
+    unsigned long long modulus;
+    while (std::getline(in, line)) {
+        if (parse_modulus_line(line, modulus)) moduli.push_back(modulus);
+    }
+    return moduli;
+}
+
+std::vector<unsigned long long> read_moduli_file(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Cannot open moduli file: " + path);
+    return read_moduli(in);
+}
+
+std::vector<unsigned long long> batch_gcd(const std::vector<unsigned long long>& moduli, unsigned int threads) {
+    if (moduli.empty()) return {};
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // Product tree: tree[0] holds the moduli, each level above multiplies adjacent pairs.
+    std::vector<std::vector<Limbs>> tree;
+    tree.emplace_back(moduli.size());
+    for (size_t i = 0; i < moduli.size(); ++i) {
+        if (moduli[i] < 2) throw std::runtime_error("Invalid modulus: " + std::to_string(moduli[i]));
+        tree[0][i] = Limbs{moduli[i]};
+    }
+    while (tree.back().size() > 1) {
+        const std::vector<Limbs>& below = tree.back();
+        std::vector<Limbs> level((below.size() + 1) / 2);
+        unsigned int spare = std::max<size_t>(1, threads / level.size());
+        parallel_for(level.size(), threads, [&](size_t i) {
+            level[i] = 2 * i + 1 < below.size() ? mul(below[2 * i], below[2 * i + 1], spare) : below[2 * i];
+        });
+        tree.push_back(std::move(level));
+    }
+
+    // Remainder tree: walk down reducing the root product modulo the square of every node,
+    // releasing each product level once its remainders are known.
+    std::vector<Limbs> remainders = std::move(tree.back());
+    tree.pop_back();
+    while (!tree.empty()) {
+        const std::vector<Limbs>& level = tree.back();
+        std::vector<Limbs> next(level.size());
+        unsigned int spare = std::max<size_t>(1, threads / level.size());
+        parallel_for(level.size(), threads, [&](size_t i) {
+            next[i] = reduce(remainders[i / 2], mul(level[i], level[i], spare), spare);
+        });
+        remainders = std::move(next);
+        tree.pop_back();
+    }
+
+    // gcd(n, (P mod n^2) / n) == gcd(n, P / n)
+    std::vector<unsigned long long> result(moduli.size());
+    parallel_for(moduli.size(), threads, [&](size_t i) {
+        unsigned long long n = moduli[i];
+        unsigned long long cofactor = static_cast<unsigned long long>(to_u128(remainders[i]) / n);
+        result[i] = std::gcd(n, cofactor);
+    });
+    return result;
+}
+
+std::vector<CompromisedKey> find_compromised_keys(const std::vector<unsigned long long>& moduli, unsigned int threads) {
+    // Group equal moduli first: duplicates are reported from the grouping, and batch GCD runs on
+    // distinct values only, so gcd == n means every prime of n is shared with other keys.
+    std::vector<size_t> order(moduli.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return moduli[a] != moduli[b] ? moduli[a] < moduli[b] : a < b;
+    });
+    std::vector<unsigned long long> distinct;
+    std::vector<size_t> group_start;
+    for (size_t k = 0; k < order.size(); ++k) {
+        if (distinct.empty() || moduli[order[k]] != distinct.back()) {
+            distinct.push_back(moduli[order[k]]);
+            group_start.push_back(k);
+        }
+    }
+    group_start.push_back(order.size());
+
+    std::vector<unsigned long long> gcds = batch_gcd(distinct, threads);
+
+    // gcd == n: both primes are shared, so the gcd does not split n; factor it directly instead.
+    // Pollard rho costs about n^(1/4) steps per key, independent of how many keys are flagged.
+    std::vector<size_t> unsplit;
+    for (size_t d = 0; d < distinct.size(); ++d) {
+        if (gcds[d] == distinct[d]) unsplit.push_back(d);
+    }
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    parallel_for(unsplit.size(), threads, [&](size_t i) {
+        size_t d = unsplit[i];
+        unsigned long long factor = pollard_rho(distinct[d]);
+        if (factor != 0) gcds[d] = factor;
+    });
+
+    std::vector<CompromisedKey> compromised;
+    for (size_t d = 0; d < distinct.size(); ++d) {
+        bool duplicated = group_start[d + 1] - group_start[d] > 1;
+        if (gcds[d] == 1 && !duplicated) continue;
+
+        unsigned long long n = distinct[d];
+        unsigned long long g = gcds[d];
+        unsigned long long p = 0, q = 0;
+        if (g != 1 && g != n) {
+            p = std::min(g, n / g);
+            q = std::max(g, n / g);
+        }
+        for (size_t k = group_start[d]; k < group_start[d + 1]; ++k) {
+            compromised.push_back({order[k], n, p, q, duplicated});
+        }
+    }
+
+    std::sort(compromised.begin(), compromised.end(), [](const CompromisedKey& a, const CompromisedKey& b) {
+        return a.index < b.index;
+    });
+    return compromised;
+}
@@ -0,0 +1,33 @@
+#ifndef BATCH_GCD_H
+#define BATCH_GCD_H
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+
+// A modulus from the corpus that shares a prime with another modulus or is an exact duplicate.
+// p and q are the recovered factors (p * q == modulus); both are 0 when the modulus could not be
+// split: a duplicate that shares no prime with any other distinct modulus, or a modulus that is
+// itself prime and divides another one. duplicate is set when the modulus occurs more than once.
+struct CompromisedKey {
+    size_t index;
+    unsigned long long modulus;
+    unsigned long long p;
+    unsigned long long q;
+    bool duplicate;
+};
+
+// Moduli Input: one key per line, either "n" or "e n" as returned by RSA::get_public_key.
+// Blank lines and lines starting with '#' are skipped.
+std::vector<unsigned long long> read_moduli(std::istream& in);
+std::vector<unsigned long long> read_moduli_file(const std::string& path);
+
+// Batch GCD (product tree + remainder tree): result[i] = gcd(n_i, product of all other moduli).
+// threads == 0 uses std::thread::hardware_concurrency().
+std::vector<unsigned long long> batch_gcd(const std::vector<unsigned long long>& moduli, unsigned int threads = 0);
+
+// Weak-modulus audit: runs batch_gcd and splits every modulus that shares a factor.
+std::vector<CompromisedKey> find_compromised_keys(const std::vector<unsigned long long>& moduli, unsigned int threads = 0);
+
+#endif // BATCH_GCD_H
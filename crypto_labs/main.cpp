@@ -1,8 +1,47 @@
 #include <iostream>
+#include <stdexcept>
+#include <string>
 
 #include "prime_utils.h"
 #include "test_lab_1.h"
 #include "test_lab_2.h"
+#include "test_lab_3.h"
+
+int test_lab_3(){
+    std::cout << "Choose an option:\n";
+    std::cout << "1. Audit moduli file\n";
+    std::cout << "2. Audit freshly generated keys\n";
+    std::cout << "3. Check batch GCD against pairwise gcd\n";
+    std::cout << "Enter your choice: ";
+
+    int choice;
+    std::cin >> choice;
+
+    if (choice == 1) {
+        std::string path;
+        std::cout << "Enter the path of the moduli file: ";
+        std::cin >> path;
+        audit_moduli_file(path);
+    } else if (choice == 2) {
+        int bit_length, key_count;
+        std::cout << "Enter the bit length of primes for RSA: ";
+        std::cin >> bit_length;
+        std::cout << "Enter the number of keys: ";
+        std::cin >> key_count;
+        simulate_weak_key_audit(bit_length, key_count);
+    } else if (choice == 3) {
+        // 17000 keys put the top product-tree operands past the NTT threshold.
+        bool batch_gcd_ok = batch_gcd_check(17000);
+        std::cout << "Batch GCD check: " << (batch_gcd_ok ? "passed" : "failed") << std::endl;
+        bool scaling_ok = weak_key_scaling_check(10000);
+        std::cout << "Weak-key scaling check: " << (scaling_ok ? "passed" : "failed") << std::endl;
+        return batch_gcd_ok && scaling_ok ? 0 : 1;
+    } else {
+        std::cout << "Invalid choice.\n";
+    }
+
+    return 0;
+}
 
 int test_lab_2(){
     int bit_length;
@@ -11,7 +50,11 @@ int test_lab_2(){
 
     simulate_message_exchange(bit_length);
 
-    return 0;
+    std::cout << "\nAllocation-free API check:" << std::endl;
+    bool allocation_free = allocation_free_check(bit_length);
+    std::cout << "Allocation-free: " << (allocation_free ? "yes" : "no") << std::endl;
+
+    return allocation_free ? 0 : 1;
 }
 
 
@@ -69,9 +112,20 @@ int test_lab_1(){
 }
 
 
-int main() {
-    
+int main(int argc, char* argv[]) {
+    // Non-interactive key-hygiene audit: crypto_labs <moduli_file>
+    if (argc > 1) {
+        try {
+            audit_moduli_file(argv[1]);
+        } catch (const std::exception& e) {
+            std::cerr << "Audit failed: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
     //int res = test_lab_1();
+    //int res = test_lab_3();
     int res = test_lab_2();
     return res;
 }
@@ -1,8 +1,8 @@
 #include "rsa.h"
 #include "prime_utils.h"
+#include "scratch_arena.h"
+#include <algorithm>
 #include <random>
-#include <sstream>
-#include <iomanip>
 #include <iostream>
 #include <stdexcept>
 #include <functional>  // For std::hash
@@ -108,20 +108,33 @@ unsigned long long right_rotate(unsigned long long value, unsigned int count) {
     return (value >> count) | (value << (64 - count));
 }
 
-std::vector<unsigned long long> pad_message(const std::string& message) {
-    std::vector<unsigned long long> padded_message(message.begin(), message.end());
-    padded_message.push_back(0x80);  // Append '1' bit to message
-    while ((padded_message.size() % 128) != 112) {
-        padded_message.push_back(0);  // Append '0' bits until message is 896 mod 1024 bits
+// The padding ends 8 words past 112 mod 128, which is not a whole 16-word block; the
+// final block is completed with zero words.
+size_t padded_length(size_t message_length) {
+    size_t length = message_length + 1;
+    while ((length % 128) != 112) ++length;
+    return (length + 8 + 15) / 16 * 16;
+}
+
+std::span<unsigned long long> pad_message(std::span<const char> message, ScratchArena& arena) {
+    std::span<unsigned long long> padded_message = arena.allocate<unsigned long long>(padded_length(message.size()));
+    size_t i = 0;
+    for (char c : message) padded_message[i++] = static_cast<unsigned long long>(c);
+    padded_message[i++] = 0x80;  // Append '1' bit to message
+    while ((i % 128) != 112) {
+        padded_message[i++] = 0;  // Append '0' bits until message is 896 mod 1024 bits
     }
     unsigned long long message_length = message.size() * 8;
-    for (int i = 0; i < 8; ++i) {
-        padded_message.push_back(static_cast<unsigned long long>(message_length >> (56 - 8 * i)));
+    for (int j = 0; j < 8; ++j) {
+        padded_message[i++] = static_cast<unsigned long long>(message_length >> (56 - 8 * j));
+    }
+    while (i < padded_message.size()) {
+        padded_message[i++] = 0;
     }
     return padded_message;
 }
 
-std::array<unsigned long long, 8> sha256_transform(const std::array<unsigned long long, 8>& hash_values, const std::vector<unsigned long long>& message_block) {
+std::array<unsigned long long, 8> sha256_transform(const std::array<unsigned long long, 8>& hash_values, std::span<const unsigned long long> message_block) {
     std::array<unsigned long long, 8> working_vars = hash_values;
     std::array<unsigned long long, 80> w;
 
@@ -159,40 +172,76 @@ std::array<unsigned long long, 8> sha256_transform(const std::array<unsigned lon
     return new_hash_values;
 }
 
-unsigned long long RSA::custom_hash(const std::string& message) {
-    std::vector<unsigned long long> padded_message = pad_message(message);
+unsigned long long RSA::custom_hash(std::span<const char> message) {
+    ScratchArena& arena = thread_scratch_arena();
+    ScratchScope scope(arena);
+    std::span<unsigned long long> padded_message = pad_message(message, arena);
     std::array<unsigned long long, 8> hash_values = initial_hash_values;
 
     for (size_t i = 0; i < padded_message.size(); i += 16) {
-        std::vector<unsigned long long> message_block(padded_message.begin() + i, padded_message.begin() + i + 16);
-        hash_values = sha256_transform(hash_values, message_block);
+        hash_values = sha256_transform(hash_values, padded_message.subspan(i, 16));
     }
 
     // Return only the first 64 bits of the resulting hash value
     return static_cast<unsigned short>(hash_values[0] & 0xFFFF);
 }
 
-std::string RSA::encrypt(const std::string& message, const std::pair<unsigned long long, unsigned long long>& public_key) {
+void write_hex_block(unsigned long long value, char* out) {
+    static const char* hex_digits = "0123456789abcdef";
+    for (int i = 15; i >= 0; --i) {
+        out[i] = hex_digits[value & 0xF];
+        value >>= 4;
+    }
+}
+
+unsigned long long parse_hex_block(std::span<const char> hex) {
+    if (hex.empty() || hex.size() > 16) throw std::runtime_error("Invalid hex block");
+    unsigned long long value = 0;
+    for (char c : hex) {
+        unsigned long long digit;
+        if (c >= '0' && c <= '9') digit = c - '0';
+        else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+        else throw std::runtime_error("Invalid hex digit");
+        value = (value << 4) | digit;
+    }
+    return value;
+}
+
+size_t RSA::encrypt(std::span<const char> message, const std::pair<unsigned long long, unsigned long long>& public_key, std::span<char> cipher_text) {
     unsigned long long e = public_key.first;
     unsigned long long n = public_key.second;
-    std::ostringstream oss;
+    if (cipher_text.size() < message.size() * 16) throw std::runtime_error("Encryption error: output buffer too small");
+    size_t written = 0;
     for (char c : message) {
         unsigned long long m = static_cast<unsigned long long>(c);
-        unsigned long long cipher_text = modular_exponentiation(m, e, n);
-        oss << std::hex << std::setw(16) << std::setfill('0') << cipher_text;
+        write_hex_block(modular_exponentiation(m, e, n), cipher_text.data() + written);
+        written += 16;
     }
-    return oss.str();
+    return written;
 }
 
-std::string RSA::decrypt(const std::string& cipher_text) {
-    std::string message;
+size_t RSA::decrypt(std::span<const char> cipher_text, std::span<char> message) {
+    if (message.size() < (cipher_text.size() + 15) / 16) throw std::runtime_error("Decryption error: output buffer too small");
+    size_t written = 0;
     for (size_t i = 0; i < cipher_text.size(); i += 16) {
-        std::string hex_str = cipher_text.substr(i, 16);
-        unsigned long long cipher = std::stoull(hex_str, nullptr, 16);
+        unsigned long long cipher = parse_hex_block(cipher_text.subspan(i, std::min<size_t>(16, cipher_text.size() - i)));
         unsigned long long plain = crt_decrypt(cipher);
         if (plain > 255) throw std::runtime_error("Decryption error: plain text value out of ASCII range");
-        message.push_back(static_cast<char>(plain));
+        message[written++] = static_cast<char>(plain);
     }
+    return written;
+}
+
+std::string RSA::encrypt(const std::string& message, const std::pair<unsigned long long, unsigned long long>& public_key) {
+    std::string cipher_text(message.size() * 16, '0');
+    encrypt(std::span<const char>(message), public_key, std::span<char>(cipher_text));
+    return cipher_text;
+}
+
+std::string RSA::decrypt(const std::string& cipher_text) {
+    std::string message((cipher_text.size() + 15) / 16, '\0');
+    decrypt(std::span<const char>(cipher_text), std::span<char>(message));
     return message;
 }
 
@@ -204,22 +253,28 @@ unsigned long long RSA::crt_decrypt(unsigned long long cipher_text) {
     return m2 + h * q;
 }
 
-std::string RSA::sign(const std::string& message) {
-    unsigned long long hash = custom_hash(message);
-    std::cout << "Message hash: " << hash << std::endl;
-    unsigned long long signature = modular_exponentiation(hash, d, n);
-    std::ostringstream oss;
-    oss << std::hex << std::setw(16) << std::setfill('0') << signature;
-    return oss.str();
+size_t RSA::sign(std::span<const char> message, std::span<char> signature) {
+    if (signature.size() < 16) throw std::runtime_error("Signing error: output buffer too small");
+    write_hex_block(modular_exponentiation(custom_hash(message), d, n), signature.data());
+    return 16;
 }
 
-bool RSA::verify(const std::string& message, const std::string& signature, const std::pair<unsigned long long, unsigned long long>& public_key) {
+bool RSA::verify(std::span<const char> message, std::span<const char> signature, const std::pair<unsigned long long, unsigned long long>& public_key) {
     unsigned long long e = public_key.first;
     unsigned long long n = public_key.second;
-    unsigned long long hash = custom_hash(message);
-    unsigned long long sig = std::stoull(signature, nullptr, 16);
-    unsigned long long hash_from_sig = modular_exponentiation(sig, e, n);
-    std::cout << "Hash from signature: " << hash_from_sig << std::endl;
-    std::cout << "Expected hash: " << hash << std::endl;
-    return hash == hash_from_sig;
+    unsigned long long sig = parse_hex_block(signature);
+    return custom_hash(message) == modular_exponentiation(sig, e, n);
+}
+
+std::string RSA::sign(const std::string& message) {
+    std::cout << "Message hash: " << custom_hash(message) << std::endl;
+    std::string signature(16, '0');
+    sign(std::span<const char>(message), std::span<char>(signature));
+    return signature;
+}
+
+bool RSA::verify(const std::string& message, const std::string& signature, const std::pair<unsigned long long, unsigned long long>& public_key) {
+    std::cout << "Hash from signature: " << modular_exponentiation(parse_hex_block(signature), public_key.first, public_key.second) << std::endl;
+    std::cout << "Expected hash: " << custom_hash(message) << std::endl;
+    return verify(std::span<const char>(message), std::span<const char>(signature), public_key);
 }
@@ -1,6 +1,8 @@
 #ifndef RSA_H
 #define RSA_H
 
+#include <cstddef>
+#include <span>
 #include <string>
 #include <utility>
 
@@ -17,12 +19,21 @@ public:
     std::string sign(const std::string& message);
     bool verify(const std::string& message, const std::string& signature, const std::pair<unsigned long long, unsigned long long>& public_key);
 
+    // Allocation-free overloads: results go into caller-provided buffers and the number of bytes
+    // written is returned. Cipher text and signatures take 16 hex characters per block; scratch
+    // memory comes from the calling thread's ScratchArena.
+    size_t encrypt(std::span<const char> message, const std::pair<unsigned long long, unsigned long long>& public_key, std::span<char> cipher_text);
+    size_t decrypt(std::span<const char> cipher_text, std::span<char> message);
+
+    size_t sign(std::span<const char> message, std::span<char> signature);
+    bool verify(std::span<const char> message, std::span<const char> signature, const std::pair<unsigned long long, unsigned long long>& public_key);
+
 private:
     unsigned long long generate_prime(int bit_length);
     unsigned long long compute_carmichael(unsigned long long p, unsigned long long q);
     unsigned long long mod_inverse(unsigned long long a, unsigned long long m);
     unsigned long long hash_message(const std::string& message);
-    unsigned long long custom_hash(const std::string& message);
+    unsigned long long custom_hash(std::span<const char> message);
     unsigned long long crt_decrypt(unsigned long long cipher_text);
 
     unsigned long long p, q, n, e, d;
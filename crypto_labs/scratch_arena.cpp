@@ -0,0 +1,39 @@
+#include "scratch_arena.h"
+#include <algorithm>
+
+const size_t initial_block_size = 4096;
+
+ScratchArena::Mark ScratchArena::mark() const {
+    return {current, offset};
+}
+
+void ScratchArena::rewind(Mark mark) {
+    current = mark.block;
+    offset = mark.offset;
+}
+
+void* ScratchArena::allocate_bytes(size_t bytes, size_t alignment) {
+    while (current < blocks.size()) {
+        Block& block = blocks[current];
+        size_t start = (offset + alignment - 1) & ~(alignment - 1);
+        if (start + bytes <= block.size) {
+            offset = start + bytes;
+            return block.data.get() + start;
+        }
+        ++current;
+        offset = 0;
+    }
+
+    // Grow geometrically; the new block is kept for every later call on this thread.
+    // new[] aligns blocks for any fundamental type, so offsets only need aligning within a block.
+    size_t size = std::max(bytes, blocks.empty() ? initial_block_size : 2 * blocks.back().size);
+    blocks.push_back({std::make_unique<unsigned char[]>(size), size});
+    current = blocks.size() - 1;
+    offset = bytes;
+    return blocks.back().data.get();
+}
+
+ScratchArena& thread_scratch_arena() {
+    thread_local ScratchArena arena;
+    return arena;
+}
@@ -0,0 +1,56 @@
+#ifndef SCRATCH_ARENA_H
+#define SCRATCH_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+// Per-thread bump allocator for short-lived scratch buffers. Memory is handed out by bumping an
+// offset and reclaimed all at once by rewinding to a mark, so blocks are allocated only while the
+// arena grows to its high-water mark and reused on every later call.
+class ScratchArena {
+public:
+    struct Mark {
+        size_t block;
+        size_t offset;
+    };
+
+    template <typename T>
+    std::span<T> allocate(size_t count) {
+        return {static_cast<T*>(allocate_bytes(count * sizeof(T), alignof(T))), count};
+    }
+
+    Mark mark() const;
+    void rewind(Mark mark);
+
+private:
+    void* allocate_bytes(size_t bytes, size_t alignment);
+
+    struct Block {
+        std::unique_ptr<unsigned char[]> data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks;
+    size_t current = 0;
+    size_t offset = 0;
+};
+
+ScratchArena& thread_scratch_arena();
+
+// Releases everything allocated from the arena during its lifetime.
+class ScratchScope {
+public:
+    explicit ScratchScope(ScratchArena& arena) : arena(arena), saved(arena.mark()) {}
+    ~ScratchScope() { arena.rewind(saved); }
+
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
+
+private:
+    ScratchArena& arena;
+    ScratchArena::Mark saved;
+};
+
+#endif // SCRATCH_ARENA_H
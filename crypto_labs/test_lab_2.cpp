@@ -1,11 +1,36 @@
 
 #include <iostream>
 #include <chrono>
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <thread>
 
 #include "prime_utils.h"
 #include "test_lab_2.h"
 #include "rsa.h"
 
+// Counting allocator: every global operator new bumps the calling thread's counter, so a zero delta on the
+// checking thread proves its code path never touched the heap. Per-thread plain counters keep other threads
+// from contending on a shared cache line.
+thread_local size_t heap_allocations = 0;
+
+void* operator new(std::size_t size) {
+    ++heap_allocations;
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
 void simulate_message_exchange(int bit_length) {
     RSA alice(bit_length);
     RSA bob(bit_length);
@@ -44,3 +69,57 @@ void simulate_message_exchange(int bit_length) {
     std::cout << "Verification: " << (is_verified ? "success" : "failure") << std::endl;
     std::cout << "Verification time: " << verification_time.count() << " seconds" << std::endl;
 }
+
+bool allocation_free_check(int bit_length) {
+    RSA alice(bit_length);
+    RSA bob(bit_length);
+
+    auto alice_public_key = alice.get_public_key();
+    auto bob_public_key = bob.get_public_key();
+
+    const char text[] = "Hello Bob!";
+    std::span<const char> message(text, sizeof(text) - 1);
+    std::array<char, 16 * (sizeof(text) - 1)> cipher_text;
+    std::array<char, sizeof(text) - 1> decrypted;
+    std::array<char, 16> signature;
+
+    // The hash must not depend on what the thread's arena held before, nor on which thread runs it.
+    std::array<char, 16> fresh_signature, before_signature, after_signature;
+    bool fresh_verified = false;
+    std::thread fresh_thread([&] { alice.sign(message, fresh_signature); });
+    fresh_thread.join();
+    alice.sign(message, before_signature);
+    std::string long_text(300, 'x');
+    alice.sign(std::span<const char>(long_text), signature);
+    alice.sign(message, after_signature);
+    std::thread verify_thread([&] { fresh_verified = bob.verify(message, after_signature, alice_public_key); });
+    verify_thread.join();
+    bool hash_stable = fresh_signature == before_signature && before_signature == after_signature && fresh_verified;
+    std::cout << "Hash stable across calls and threads: " << (hash_stable ? "yes" : "no") << std::endl;
+
+    // The first round grows each thread's scratch arena to its high-water mark.
+    alice.encrypt(message, bob_public_key, cipher_text);
+    bob.decrypt(cipher_text, decrypted);
+    alice.sign(message, signature);
+    bob.verify(message, signature, alice_public_key);
+
+    const int rounds = 1000;
+    bool round_trip_ok = true;
+    size_t before = heap_allocations;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        size_t cipher_size = alice.encrypt(message, bob_public_key, cipher_text);
+        size_t plain_size = bob.decrypt(std::span<const char>(cipher_text.data(), cipher_size), decrypted);
+        size_t signature_size = alice.sign(message, signature);
+        bool is_verified = bob.verify(message, std::span<const char>(signature.data(), signature_size), alice_public_key);
+        round_trip_ok = round_trip_ok && is_verified && std::equal(message.begin(), message.end(), decrypted.begin(), decrypted.begin() + plain_size);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    size_t allocations = heap_allocations - before;
+    std::chrono::duration<double> round_time = (end - start) / rounds;
+
+    std::cout << "Round trip: " << (round_trip_ok ? "success" : "failure") << std::endl;
+    std::cout << "Heap allocations over " << rounds << " rounds: " << allocations << std::endl;
+    std::cout << "Time per round: " << round_time.count() << " seconds" << std::endl;
+    return hash_stable && allocations == 0;
+}
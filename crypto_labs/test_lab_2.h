@@ -2,6 +2,7 @@
 #define TEST_LAB_2_H
 
 void simulate_message_exchange(int bit_length);
+bool allocation_free_check(int bit_length);
 
 #endif // IO_UTILS_H
 
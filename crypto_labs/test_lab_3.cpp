@@ -0,0 +1,160 @@
+#include <iostream>
+#include <chrono>
+#include <numeric>
+#include <random>
+#include <unordered_set>
+
+#include "batch_gcd.h"
+#include "test_lab_3.h"
+#include "rsa.h"
+#include "prime_utils.h"
+
+void report_compromised_keys(const std::vector<unsigned long long>& moduli) {
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<CompromisedKey> compromised = find_compromised_keys(moduli);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> audit_time = end - start;
+
+    for (const CompromisedKey& key : compromised) {
+        std::cout << "Key #" << key.index << ": n = " << key.modulus;
+        if (key.p != 0)
+            std::cout << " = " << key.p << " * " << key.q << (key.duplicate ? " (duplicate modulus)" : "") << std::endl;
+        else if (key.duplicate)
+            std::cout << " (duplicate modulus, factors not recovered)" << std::endl;
+        else
+            std::cout << " (shares a factor, factors not recovered)" << std::endl;
+    }
+    std::cout << "Moduli audited: " << moduli.size() << std::endl;
+    std::cout << "Compromised keys: " << compromised.size() << std::endl;
+    std::cout << "Audit time: " << audit_time.count() << " seconds" << std::endl;
+}
+
+void audit_moduli_file(const std::string& path) {
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<unsigned long long> moduli = read_moduli_file(path);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> read_time = end - start;
+    std::cout << "Read time: " << read_time.count() << " seconds" << std::endl;
+
+    report_compromised_keys(moduli);
+}
+
+void simulate_weak_key_audit(int bit_length, int key_count) {
+    // Small primes make shared factors between independently generated keys likely.
+    std::vector<unsigned long long> moduli;
+    for (int i = 0; i < key_count; ++i) {
+        RSA key(bit_length);
+        moduli.push_back(key.get_public_key().second);
+    }
+
+    report_compromised_keys(moduli);
+}
+
+bool batch_gcd_check(int key_count) {
+    // Seeded corpus of 31-bit-prime moduli: independent keys plus a duplicated key, a key that shares
+    // one prime and a key that shares both. Large corpora push the top tree levels onto the NTT path.
+    std::mt19937_64 gen(2024);
+    std::uniform_int_distribution<unsigned long long> dis(1ULL << 30, (1ULL << 31) - 1);
+    std::vector<unsigned long long> primes;
+    std::unordered_set<unsigned long long> seen;
+    while (primes.size() < 2 * static_cast<size_t>(key_count) + 1) {
+        unsigned long long candidate = dis(gen) | 1;
+        if (miller_rabin_test(candidate, 20) && seen.insert(candidate).second) primes.push_back(candidate);
+    }
+
+    std::vector<unsigned long long> moduli;
+    for (int i = 0; i < key_count; ++i) {
+        moduli.push_back(primes[2 * i] * primes[2 * i + 1]);
+    }
+    moduli[1] = primes[0] * primes[5];               // both primes shared, with keys 0 and 2
+    moduli[7] = primes[9] * primes[2 * key_count];  // one prime shared, with key 4
+    moduli[key_count - 1] = moduli[key_count / 2];   // exact duplicate
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<unsigned long long> gcds = batch_gcd(moduli);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> batch_time = end - start;
+
+    // Reference: gcd(n_i, prod n_j) is the lcm of the pairwise gcds for squarefree moduli.
+    start = std::chrono::high_resolution_clock::now();
+    std::vector<unsigned long long> expected(moduli.size(), 1);
+    for (size_t i = 0; i < moduli.size(); ++i) {
+        for (size_t j = i + 1; j < moduli.size(); ++j) {
+            unsigned long long g = std::gcd(moduli[i], moduli[j]);
+            if (g == 1) continue;
+            expected[i] = expected[i] / std::gcd(expected[i], g) * g;
+            expected[j] = expected[j] / std::gcd(expected[j], g) * g;
+        }
+    }
+    size_t mismatches = 0;
+    for (size_t i = 0; i < moduli.size(); ++i) {
+        if (expected[i] != gcds[i]) ++mismatches;
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> pairwise_time = end - start;
+
+    // Every key with a shared factor is reported, and recovered factors multiply back to the modulus.
+    std::vector<CompromisedKey> compromised = find_compromised_keys(moduli);
+    size_t flagged = 0;
+    for (unsigned long long g : gcds) {
+        if (g != 1) ++flagged;
+    }
+    bool factors_ok = compromised.size() == flagged;
+    for (const CompromisedKey& key : compromised) {
+        if (key.p != 0 && key.p * key.q != key.modulus) factors_ok = false;
+    }
+
+    std::cout << "Moduli checked: " << moduli.size() << std::endl;
+    std::cout << "Batch GCD time: " << batch_time.count() << " seconds" << std::endl;
+    std::cout << "Pairwise gcd time: " << pairwise_time.count() << " seconds" << std::endl;
+    std::cout << "Mismatches against pairwise gcd: " << mismatches << std::endl;
+    std::cout << "Compromised keys reported: " << compromised.size() << " (expected " << flagged << ")" << std::endl;
+    return mismatches == 0 && factors_ok && flagged == 7;
+}
+
+bool weak_key_scaling_check(int key_count) {
+    // Every key draws both primes from a small pool, so nearly every modulus has gcd == n and its
+    // factors come from the per-key recovery step. That step is timed as the audit time minus the
+    // batch GCD time; quadrupling the corpus must cost about 4x there, not the 16x of a pairwise scan.
+    std::mt19937_64 gen(2025);
+    std::uniform_int_distribution<unsigned long long> dis(1ULL << 23, (1ULL << 24) - 1);
+    std::vector<unsigned long long> pool;
+    std::unordered_set<unsigned long long> seen;
+    while (pool.size() < 4096) {
+        unsigned long long candidate = dis(gen) | 1;
+        if (miller_rabin_test(candidate, 20) && seen.insert(candidate).second) pool.push_back(candidate);
+    }
+    std::uniform_int_distribution<size_t> pick(0, pool.size() - 1);
+
+    double recovery_times[2];
+    bool factors_ok = true;
+    for (int round = 0; round < 2; ++round) {
+        std::vector<unsigned long long> moduli;
+        int count = round == 0 ? key_count : 4 * key_count;
+        for (int i = 0; i < count; ++i) {
+            size_t a = pick(gen), b = pick(gen);
+            if (a == b) b = (b + 1) % pool.size();
+            moduli.push_back(pool[a] * pool[b]);
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        batch_gcd(moduli);
+        auto middle = std::chrono::high_resolution_clock::now();
+        std::vector<CompromisedKey> compromised = find_compromised_keys(moduli);
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> batch_time = middle - start;
+        std::chrono::duration<double> audit_time = end - middle;
+        recovery_times[round] = std::max(audit_time.count() - batch_time.count(), 1e-6);
+
+        for (const CompromisedKey& key : compromised) {
+            if (key.p == 0 || key.p * key.q != key.modulus) factors_ok = false;
+        }
+        std::cout << "Weak keys audited: " << count << ", compromised: " << compromised.size() << std::endl;
+        std::cout << "Audit time: " << audit_time.count() << " seconds (batch GCD " << batch_time.count()
+                  << ")" << std::endl;
+    }
+
+    double ratio = recovery_times[1] / recovery_times[0];
+    std::cout << "Factor recovery time ratio for 4x keys: " << ratio << std::endl;
+    return factors_ok && ratio < 8;
+}
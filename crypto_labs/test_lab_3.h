@@ -0,0 +1,13 @@
+#ifndef TEST_LAB_3_H
+#define TEST_LAB_3_H
+
+#include <string>
+#include <vector>
+
+void report_compromised_keys(const std::vector<unsigned long long>& moduli);
+void audit_moduli_file(const std::string& path);
+void simulate_weak_key_audit(int bit_length, int key_count);
+bool batch_gcd_check(int key_count);
+bool weak_key_scaling_check(int key_count);
+
+#endif // TEST_LAB_3_H